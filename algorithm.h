@@ -0,0 +1,354 @@
+#ifndef _ALGORITHM_H
+#define _ALGORITHM_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+
+#include "thread_pool.h"
+#include "vector.h"
+
+
+// Ranges no longer than threshold run serially on the calling thread,
+// larger ones are cut into grain sized pieces for the pool.
+constexpr unsigned long parallel_default_grain     = 1ul << 14;
+constexpr unsigned long parallel_default_threshold = 1ul << 15;
+
+
+inline bool __parallel_serial(unsigned long size, unsigned long threshold,
+                              thread_pool &pool) {
+    return size <= threshold || pool.concurrency() == 1;
+}
+
+
+template <typename T, typename F>
+void parallel_for_each(T *begin, T *end, F func,
+                       unsigned long grain = parallel_default_grain,
+                       unsigned long threshold = parallel_default_threshold,
+                       thread_pool &pool = thread_pool::instance()) {
+    unsigned long size = (unsigned long)(end - begin);
+
+    if (__parallel_serial(size, threshold, pool)) {
+        for (; begin != end; ++begin) {
+            func(*begin);
+        }
+        return;
+    }
+
+    pool.parallel_for(0, size, grain, [begin, &func](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            func(begin[lo]);
+        }
+    });
+}
+
+template <typename T, typename F>
+void parallel_for_each(vector<T> &vec, F func,
+                       unsigned long grain = parallel_default_grain,
+                       unsigned long threshold = parallel_default_threshold,
+                       thread_pool &pool = thread_pool::instance()) {
+    parallel_for_each(vec.begin(), vec.end(), func, grain, threshold, pool);
+}
+
+
+template <typename T, typename U, typename F>
+void parallel_transform(T *begin, T *end, U *out, F func,
+                        unsigned long grain = parallel_default_grain,
+                        unsigned long threshold = parallel_default_threshold,
+                        thread_pool &pool = thread_pool::instance()) {
+    unsigned long size = (unsigned long)(end - begin);
+
+    if (__parallel_serial(size, threshold, pool)) {
+        for (; begin != end; ++out, ++begin) {
+            *out = func(*begin);
+        }
+        return;
+    }
+
+    pool.parallel_for(0, size, grain, [begin, out, &func](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            out[lo] = func(begin[lo]);
+        }
+    });
+}
+
+// dst is resized to src.size() before being written
+template <typename T, typename U, typename F>
+void parallel_transform(vector<T> const &src, vector<U> &dst, F func,
+                        unsigned long grain = parallel_default_grain,
+                        unsigned long threshold = parallel_default_threshold,
+                        thread_pool &pool = thread_pool::instance()) {
+    dst.resize(src.size());
+    parallel_transform(src.begin(), src.end(), dst.begin(), func, grain, threshold, pool);
+}
+
+
+// op must be associative, blocks are folded left to right onto init
+template <typename T, typename U, typename F = std::plus<>>
+U parallel_reduce(T *begin, T *end, U init, F op = F(),
+                  unsigned long grain = parallel_default_grain,
+                  unsigned long threshold = parallel_default_threshold,
+                  thread_pool &pool = thread_pool::instance()) {
+    unsigned long size = (unsigned long)(end - begin);
+
+    if (__parallel_serial(size, threshold, pool)) {
+        for (; begin != end; ++begin) {
+            init = op(init, *begin);
+        }
+        return init;
+    }
+
+    grain = grain == 0 ? 1 : grain;
+    unsigned long blocks = (size + grain - 1) / grain;
+    vector<U> partials;
+    partials.resize(blocks, init);
+
+    pool.parallel_for(0, blocks, 1, [&](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            T *pos = begin + lo * grain;
+            T *last = lo == blocks - 1 ? end : pos + grain;
+
+            U acc = *pos;
+            for (++pos; pos != last; ++pos) {
+                acc = op(acc, *pos);
+            }
+            partials[lo] = static_cast<U&&>(acc);
+        }
+    });
+
+    for (auto &partial : partials) {
+        init = op(init, partial);
+    }
+    return init;
+}
+
+template <typename T, typename U, typename F = std::plus<>>
+U parallel_reduce(vector<T> const &vec, U init, F op = F(),
+                  unsigned long grain = parallel_default_grain,
+                  unsigned long threshold = parallel_default_threshold,
+                  thread_pool &pool = thread_pool::instance()) {
+    return parallel_reduce(vec.begin(), vec.end(), init, op, grain, threshold, pool);
+}
+
+
+// Two passes: block totals first, then every block is rescanned from
+// the carry of the blocks before it. out may alias begin.
+template <typename T, typename U, typename F = std::plus<>>
+void parallel_inclusive_scan(T *begin, T *end, U *out, F op = F(),
+                             unsigned long grain = parallel_default_grain,
+                             unsigned long threshold = parallel_default_threshold,
+                             thread_pool &pool = thread_pool::instance()) {
+    unsigned long size = (unsigned long)(end - begin);
+
+    if (size == 0) {
+        return;
+    }
+
+    if (__parallel_serial(size, threshold, pool)) {
+        U acc = *begin;
+        *out = acc;
+        for (++begin, ++out; begin != end; ++out, ++begin) {
+            acc = op(acc, *begin);
+            *out = acc;
+        }
+        return;
+    }
+
+    grain = grain == 0 ? 1 : grain;
+    unsigned long blocks = (size + grain - 1) / grain;
+    vector<U> carry;
+    carry.resize(blocks, *begin);
+
+    pool.parallel_for(0, blocks - 1, 1, [&](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            T *pos = begin + lo * grain;
+            T *last = pos + grain;
+
+            U acc = *pos;
+            for (++pos; pos != last; ++pos) {
+                acc = op(acc, *pos);
+            }
+            carry[lo + 1] = static_cast<U&&>(acc);
+        }
+    });
+
+    for (unsigned long idx = 2; idx < blocks; ++idx) {
+        carry[idx] = op(carry[idx - 1], carry[idx]);
+    }
+
+    pool.parallel_for(0, blocks, 1, [&](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            unsigned long first = lo * grain;
+            unsigned long last = lo == blocks - 1 ? size : first + grain;
+
+            U acc = lo == 0 ? U(begin[first]) : op(carry[lo], begin[first]);
+            out[first] = acc;
+            for (++first; first != last; ++first) {
+                acc = op(acc, begin[first]);
+                out[first] = acc;
+            }
+        }
+    });
+}
+
+template <typename T, typename F = std::plus<>>
+void parallel_inclusive_scan(vector<T> &vec, F op = F(),
+                             unsigned long grain = parallel_default_grain,
+                             unsigned long threshold = parallel_default_threshold,
+                             thread_pool &pool = thread_pool::instance()) {
+    parallel_inclusive_scan(vec.begin(), vec.end(), vec.begin(), op, grain, threshold, pool);
+}
+
+
+// Number of elements taken from a among the first k elements of the
+// stable merge of a and b, found by binary search on the merge path.
+template <typename T, typename Compare>
+unsigned long __merge_corank(unsigned long k, T *a, unsigned long a_size,
+                             T *b, unsigned long b_size, Compare &comp) {
+    unsigned long lo = k > b_size ? k - b_size : 0;
+    unsigned long hi = k < a_size ? k : a_size;
+
+    while (lo < hi) {
+        unsigned long i = lo + (hi - lo) / 2;
+        if (!comp(b[k - i - 1], a[i])) {
+            lo = i + 1;
+        }
+        else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+// Merges the sorted runs of width elements in src pairwise into dst.
+// The output is cut into grain sized pieces, width being a multiple of
+// grain no piece straddles two pairs. Every piece first finds where its
+// inputs start by co-ranking, then all pieces merge, so even the last
+// merge of two halves is spread over the whole pool. The split points are
+// computed before any element is moved out of src.
+template <typename T, typename Compare>
+void __parallel_merge_pass(T *src, T *dst, unsigned long size, unsigned long width,
+                           Compare &comp, unsigned long grain, thread_pool &pool) {
+    unsigned long pieces = (size + grain - 1) / grain;
+    vector<unsigned long> splits;
+    splits.resize(pieces);
+
+    auto bounds = [&](unsigned long piece, unsigned long &first,
+                      unsigned long &mid, unsigned long &last) {
+        first = piece * grain / (width * 2) * (width * 2);
+        mid = std::min(first + width, size);
+        last = std::min(first + width * 2, size);
+    };
+
+    pool.parallel_for(0, pieces, 1, [&](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            unsigned long first, mid, last;
+            bounds(lo, first, mid, last);
+            splits[lo] = __merge_corank(lo * grain - first, src + first, mid - first,
+                                        src + mid, last - mid, comp);
+        }
+    });
+
+    pool.parallel_for(0, pieces, 1, [&](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            unsigned long first, mid, last;
+            bounds(lo, first, mid, last);
+
+            unsigned long begin = lo * grain;
+            unsigned long end = std::min(begin + grain, last);
+            unsigned long a_lo = splits[lo];
+            unsigned long a_hi = end == last ? mid - first : splits[lo + 1];
+
+            T *a_pos = src + first + a_lo;
+            T *a_end = src + first + a_hi;
+            T *b_pos = src + mid + (begin - first - a_lo);
+            T *b_end = src + mid + (end - first - a_hi);
+            T *out = dst + begin;
+
+            for (; a_pos != a_end && b_pos != b_end; ++out) {
+                *out = comp(*b_pos, *a_pos) ? static_cast<T&&>(*b_pos++) : static_cast<T&&>(*a_pos++);
+            }
+            out = std::move(a_pos, a_end, out);
+            std::move(b_pos, b_end, out);
+        }
+    });
+}
+
+// Blocks of grain elements are sorted independently, then merged pairwise
+// in log2(blocks) rounds, ping-ponging between the range and a scratch
+// buffer of size elements that is filled, moved back and destroyed in
+// parallel.
+template <typename T, typename Compare = std::less<>>
+void parallel_sort(T *begin, T *end, Compare comp = Compare(),
+                   unsigned long grain = parallel_default_grain,
+                   unsigned long threshold = parallel_default_threshold,
+                   thread_pool &pool = thread_pool::instance()) {
+    unsigned long size = (unsigned long)(end - begin);
+
+    if (__parallel_serial(size, threshold, pool)) {
+        std::sort(begin, end, comp);
+        return;
+    }
+
+    grain = grain == 0 ? 1 : grain;
+    unsigned long blocks = (size + grain - 1) / grain;
+
+    pool.parallel_for(0, blocks, 1, [&](unsigned long lo, unsigned long hi) {
+        for (; lo != hi; ++lo) {
+            T *first = begin + lo * grain;
+            T *last = lo == blocks - 1 ? end : first + grain;
+            std::sort(first, last, comp);
+        }
+    });
+
+    if (blocks == 1) {
+        return;
+    }
+
+    struct __scratch {
+        T *arr;
+        unsigned long size;
+        thread_pool &pool;
+        unsigned long grain;
+
+        ~__scratch() {
+            pool.parallel_for(0, size, grain, [this](unsigned long lo, unsigned long hi) {
+                std::destroy(arr + lo, arr + hi);
+            });
+            ::operator delete(static_cast<void*>(arr));
+        }
+    };
+
+    T *buffer = static_cast<T*>(::operator new(size * sizeof(T)));
+    pool.parallel_for(0, size, grain, [&](unsigned long lo, unsigned long hi) {
+        std::uninitialized_move(begin + lo, begin + hi, buffer + lo);
+    });
+    __scratch scratch{ buffer, size, pool, grain };
+
+    T *src = buffer;
+    T *dst = begin;
+    for (unsigned long width = grain; width < size; width *= 2) {
+        __parallel_merge_pass(src, dst, size, width, comp, grain, pool);
+
+        T *temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != begin) {
+        pool.parallel_for(0, size, grain, [&](unsigned long lo, unsigned long hi) {
+            std::move(src + lo, src + hi, begin + lo);
+        });
+    }
+}
+
+template <typename T, typename Compare = std::less<>>
+void parallel_sort(vector<T> &vec, Compare comp = Compare(),
+                   unsigned long grain = parallel_default_grain,
+                   unsigned long threshold = parallel_default_threshold,
+                   thread_pool &pool = thread_pool::instance()) {
+    parallel_sort(vec.begin(), vec.end(), comp, grain, threshold, pool);
+}
+
+#endif /* _ALGORITHM_H */
@@ -0,0 +1,202 @@
+#ifndef _BUFFER_CACHE_H
+#define _BUFFER_CACHE_H
+
+#include <new>
+
+
+// Thread local free lists of vector storage, bucketed by power of two
+// byte size. Enabled by building with -DVECTOR_BUFFER_CACHE, the
+// containers then round every allocation up to its bucket so that any
+// freed block can serve a later request of the same bucket, whichever
+// thread allocated it. The macro changes inline functions of every
+// container, so it must be set for the whole program on the command line:
+// a #define before one include lets translation units disagree, which is
+// an ODR violation and frees cached blocks with operator delete.
+class buffer_cache {
+public:
+    typedef unsigned long size_type;
+
+    static constexpr size_type min_block     = 16;
+    static constexpr size_type max_block     = 1ul << 20;
+    static constexpr size_type default_limit = 4ul << 20;
+
+private:
+    static constexpr size_type __bucket_cnt = 64;
+
+    struct __node {
+        __node *next;
+    };
+
+    __node *__buckets[__bucket_cnt];
+    size_type __cached;
+    size_type __limit;
+    size_type __hits;
+    size_type __misses;
+    bool __enabled;
+
+    inline static thread_local bool __torn_down = false;
+
+public:
+    buffer_cache() noexcept;
+    buffer_cache(buffer_cache const &cache) = delete;
+    ~buffer_cache();
+
+    buffer_cache& operator=(buffer_cache const &cache) = delete;
+
+    [[nodiscard]] static void* allocate(size_type bytes);
+    static void deallocate(void *ptr, size_type bytes) noexcept;
+    static size_type block_size(size_type bytes) noexcept;
+    static buffer_cache& local() noexcept;
+
+    void enable(bool enabled) noexcept;
+    void limit(size_type bytes) noexcept;
+    void clear() noexcept;
+
+    bool enabled() const noexcept;
+    size_type limit() const noexcept;
+    size_type size() const noexcept;
+    size_type hits() const noexcept;
+    size_type misses() const noexcept;
+
+private:
+    static size_type __bucket(size_type bytes) noexcept;
+
+    void* __pop(size_type bytes);
+    bool __push(void *ptr, size_type bytes) noexcept;
+};
+
+
+inline buffer_cache::buffer_cache() noexcept
+    : __buckets()
+    , __cached(0)
+    , __limit(default_limit)
+    , __hits(0)
+    , __misses(0)
+    , __enabled(true)
+{}
+
+inline buffer_cache::~buffer_cache() {
+    clear();
+    __torn_down = true;
+}
+
+inline void* buffer_cache::allocate(size_type bytes) {
+    bytes = block_size(bytes);
+
+    if (!__torn_down && bytes <= max_block) {
+        void *ptr = local().__pop(bytes);
+        if (ptr) {
+            return ptr;
+        }
+    }
+
+    return ::operator new(bytes);
+}
+
+inline void buffer_cache::deallocate(void *ptr, size_type bytes) noexcept {
+    if (!ptr) {
+        return;
+    }
+
+    bytes = block_size(bytes);
+
+    if (!__torn_down && bytes <= max_block && local().__push(ptr, bytes)) {
+        return;
+    }
+
+    ::operator delete(ptr);
+}
+
+// Requests above max_block are passed through to the global heap as is
+inline auto buffer_cache::block_size(size_type bytes) noexcept -> size_type {
+    if (bytes > max_block) {
+        return bytes;
+    }
+
+    return bytes <= min_block ? min_block : size_type(1) << __bucket(bytes);
+}
+
+inline buffer_cache& buffer_cache::local() noexcept {
+    static thread_local buffer_cache cache;
+    return cache;
+}
+
+inline void buffer_cache::enable(bool enabled) noexcept {
+    __enabled = enabled;
+    if (!enabled) {
+        clear();
+    }
+}
+
+inline void buffer_cache::limit(size_type bytes) noexcept {
+    __limit = bytes;
+    if (__cached > __limit) {
+        clear();
+    }
+}
+
+inline void buffer_cache::clear() noexcept {
+    for (auto &bucket : __buckets) {
+        while (bucket) {
+            __node *next = bucket->next;
+            ::operator delete(static_cast<void*>(bucket));
+            bucket = next;
+        }
+    }
+
+    __cached = 0;
+}
+
+inline bool buffer_cache::enabled() const noexcept {
+    return __enabled;
+}
+
+inline auto buffer_cache::limit() const noexcept -> size_type {
+    return __limit;
+}
+
+inline auto buffer_cache::size() const noexcept -> size_type {
+    return __cached;
+}
+
+inline auto buffer_cache::hits() const noexcept -> size_type {
+    return __hits;
+}
+
+inline auto buffer_cache::misses() const noexcept -> size_type {
+    return __misses;
+}
+
+// ceil(log2(bytes)), bytes is never below min_block here
+inline auto buffer_cache::__bucket(size_type bytes) noexcept -> size_type {
+    return size_type(64 - __builtin_clzl(bytes - 1));
+}
+
+inline void* buffer_cache::__pop(size_type bytes) {
+    __node *&bucket = __buckets[__bucket(bytes)];
+
+    if (!__enabled || !bucket) {
+        ++__misses;
+        return nullptr;
+    }
+
+    __node *node = bucket;
+    bucket = node->next;
+    __cached -= bytes;
+    ++__hits;
+    return node;
+}
+
+inline bool buffer_cache::__push(void *ptr, size_type bytes) noexcept {
+    if (!__enabled || __cached + bytes > __limit) {
+        return false;
+    }
+
+    __node *&bucket = __buckets[__bucket(bytes)];
+
+    bucket = ::new (ptr) __node{bucket};
+    __cached += bytes;
+    return true;
+}
+
+#endif /* _BUFFER_CACHE_H */
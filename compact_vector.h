@@ -0,0 +1,437 @@
+#ifndef _COMPACT_VECTOR_H
+#define _COMPACT_VECTOR_H
+
+#include <climits>
+#include <new>
+#include <stdexcept>
+#include "storage.h"
+
+
+// Vector whose object is a single pointer. Size and capacity live in a
+// header in front of the elements, in the same allocation, and an empty
+// compact_vector owns no allocation at all. Meant for large collections of
+// small vectors, at the cost of a null check on size() and capacity().
+// The header keeps 32-bit counts, so a compact_vector holds at most
+// 2^32 - 1 elements and throws std::length_error past that.
+template <typename T>
+class compact_vector {
+public:
+    typedef T value_type;
+    typedef T* pointer_type;
+    typedef T const* const_pointer_type;
+    typedef T& reference_type;
+    typedef T const& const_reference_type;
+    typedef unsigned long size_type;
+
+private:
+    struct __header {
+        unsigned int size;
+        unsigned int capacity;
+    };
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "compact_vector does not support over-aligned types");
+
+    static constexpr size_type __offset =
+        (sizeof(__header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    static constexpr size_type __max_size = UINT_MAX;
+
+    value_type *__arr;
+
+public:
+    compact_vector() noexcept;
+    explicit compact_vector(size_type size);
+    compact_vector(compact_vector const &vec);
+    compact_vector(compact_vector &&vec) noexcept;
+    ~compact_vector();
+
+    void push_back(value_type const &value);
+    void push_back(value_type &&value);
+    void pop_back();
+    template <typename... Args>
+    reference_type emplace_back(Args&&... args);
+
+    void erase(const_pointer_type pos);
+
+    void resize(size_type size);
+    void swap(compact_vector &other) noexcept;
+    void clear();
+    void shrink_to_fit();
+
+    void reserve(size_type capacity);
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+
+    pointer_type data();
+    const_pointer_type data() const;
+
+    pointer_type begin();
+    pointer_type end();
+    reference_type front();
+    reference_type back();
+    reference_type at(size_type index);
+    const_pointer_type begin() const;
+    const_pointer_type end() const;
+    const_reference_type front() const;
+    const_reference_type back() const;
+    const_reference_type at(size_type index) const;
+
+    reference_type operator[](size_type index);
+    const_reference_type operator[](size_type index) const;
+    compact_vector& operator=(compact_vector const &vec);
+    compact_vector& operator=(compact_vector &&vec) noexcept;
+
+private:
+    __header* __head() const noexcept;
+    static void __check_length(size_type size);
+
+    [[nodiscard]] pointer_type __allocate(size_type capacity);
+    void __deallocate(pointer_type arr);
+    void __reallocate(size_type capacity);
+
+    template <typename... Args>
+    void __construct(const_pointer_type pos, Args&&... args);
+    void __move_construct_range(const_pointer_type dst,
+                                pointer_type begin, pointer_type end);
+
+    void __destruct(pointer_type pos);
+    void __destruct_range(pointer_type begin, pointer_type end);
+};
+
+
+template <typename T>
+compact_vector<T>::compact_vector() noexcept
+    : __arr(nullptr)
+{}
+
+template <typename T>
+compact_vector<T>::compact_vector(size_type size)
+    : __arr(nullptr) {
+    resize(size);
+}
+
+template <typename T>
+compact_vector<T>::compact_vector(compact_vector const &vec)
+    : __arr(nullptr) {
+    if (vec.empty()) {
+        return;
+    }
+
+    __arr = __allocate(vec.size());
+    for (auto const &value : vec) {
+        __construct(__arr + __head()->size++, value);
+    }
+}
+
+template <typename T>
+compact_vector<T>::compact_vector(compact_vector &&vec) noexcept
+    : __arr(vec.__arr) {
+    vec.__arr = nullptr;
+}
+
+template <typename T>
+compact_vector<T>::~compact_vector() {
+    clear();
+    __deallocate(__arr);
+    __arr = nullptr;
+}
+
+template <typename T>
+void compact_vector<T>::push_back(value_type const &value) {
+    emplace_back(value);
+}
+
+template <typename T>
+void compact_vector<T>::push_back(value_type &&value) {
+    emplace_back(static_cast<value_type&&>(value));
+}
+
+template <typename T>
+void compact_vector<T>::pop_back() {
+    __destruct(__arr + --__head()->size);
+}
+
+template <typename T>
+template <typename... Args>
+auto compact_vector<T>::emplace_back(Args&&... args) -> reference_type {
+    size_type size = this->size();
+
+    if (size < capacity()) {
+        __construct(__arr + size, ::forward<Args>(args)...);
+    }
+    else {
+        __check_length(size + 1);
+        size_type new_cap = size == 0 ? 1 : size * 2;
+        new_cap = new_cap > __max_size ? __max_size : new_cap;
+        pointer_type new_arr = __allocate(new_cap);
+
+        __construct(new_arr + size, ::forward<Args>(args)...);
+        __move_construct_range(new_arr, begin(), end());
+
+        __destruct_range(begin(), end());
+        __deallocate(__arr);
+
+        __arr = new_arr;
+    }
+
+    __head()->size = (unsigned int)(size + 1);
+    return __arr[size];
+}
+
+template <typename T>
+void compact_vector<T>::erase(const_pointer_type pos) {
+    pointer_type loc = begin() + (pos - begin());
+    pointer_type last = end() - 1;
+
+    for (; loc != last; ++loc) {
+        *loc = static_cast<value_type&&>(*(loc + 1));
+    }
+
+    __destruct(last);
+    --__head()->size;
+}
+
+template <typename T>
+void compact_vector<T>::resize(size_type size) {
+    __check_length(size);
+    size_type old_size = this->size();
+
+    if (size > capacity()) {
+        size_type new_cap = capacity() * 2 > size ? capacity() * 2 : size;
+        __reallocate(new_cap > __max_size ? __max_size : new_cap);
+    }
+
+    if (size > old_size) {
+        for (size_type idx = old_size; idx < size; ++idx) {
+            __construct(__arr + idx);
+        }
+    }
+    else {
+        __destruct_range(begin() + size, end());
+    }
+
+    if (__arr) {
+        __head()->size = (unsigned int)size;
+    }
+}
+
+template <typename T>
+void compact_vector<T>::swap(compact_vector<T> &other) noexcept {
+    auto temp_arr = __arr;
+    __arr = other.__arr;
+    other.__arr = temp_arr;
+}
+
+template <typename T>
+void compact_vector<T>::clear() {
+    if (!__arr) {
+        return;
+    }
+
+    __destruct_range(begin(), end());
+    __head()->size = 0;
+}
+
+// Drops the allocation entirely once the vector is empty
+template <typename T>
+void compact_vector<T>::shrink_to_fit() {
+    if (!__arr || size() == capacity()) {
+        return;
+    }
+
+    if (empty()) {
+        __deallocate(__arr);
+        __arr = nullptr;
+        return;
+    }
+
+    __reallocate(size());
+}
+
+template <typename T>
+void compact_vector<T>::reserve(size_type capacity) {
+    __check_length(capacity);
+    if (this->capacity() >= capacity) {
+        return;
+    }
+
+    __reallocate(capacity);
+}
+
+template <typename T>
+bool compact_vector<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template <typename T>
+auto compact_vector<T>::size() const noexcept -> size_type {
+    return __arr ? __head()->size : 0;
+}
+
+template <typename T>
+auto compact_vector<T>::capacity() const noexcept -> size_type {
+    return __arr ? __head()->capacity : 0;
+}
+
+template <typename T>
+auto compact_vector<T>::data() -> pointer_type {
+    return __arr;
+}
+
+template <typename T>
+auto compact_vector<T>::data() const -> const_pointer_type {
+    return __arr;
+}
+
+template <typename T>
+auto compact_vector<T>::begin() -> pointer_type {
+    return __arr;
+}
+
+template <typename T>
+auto compact_vector<T>::end() -> pointer_type {
+    return __arr + size();
+}
+
+template <typename T>
+auto compact_vector<T>::front() -> reference_type {
+    return *__arr;
+}
+
+template <typename T>
+auto compact_vector<T>::back() -> reference_type {
+    return *(end() - 1);
+}
+
+template <typename T>
+auto compact_vector<T>::at(size_type index) -> reference_type {
+    return __arr[index];
+}
+
+template <typename T>
+auto compact_vector<T>::begin() const -> const_pointer_type {
+    return __arr;
+}
+
+template <typename T>
+auto compact_vector<T>::end() const -> const_pointer_type {
+    return __arr + size();
+}
+
+template <typename T>
+auto compact_vector<T>::front() const -> const_reference_type {
+    return *__arr;
+}
+
+template <typename T>
+auto compact_vector<T>::back() const -> const_reference_type {
+    return *(end() - 1);
+}
+
+template <typename T>
+auto compact_vector<T>::at(size_type index) const -> const_reference_type {
+    return __arr[index];
+}
+
+template <typename T>
+auto compact_vector<T>::operator[](size_type index) -> reference_type {
+    return __arr[index];
+}
+
+template <typename T>
+auto compact_vector<T>::operator[](size_type index) const -> const_reference_type {
+    return __arr[index];
+}
+
+template <typename T>
+compact_vector<T>& compact_vector<T>::operator=(compact_vector<T> const &vec) {
+    if (this != &vec) {
+        compact_vector<T> temp(vec);
+        swap(temp);
+    }
+    return *this;
+}
+
+template <typename T>
+compact_vector<T>& compact_vector<T>::operator=(compact_vector<T> &&vec) noexcept {
+    if (this != &vec) {
+        clear();
+        __deallocate(__arr);
+
+        __arr = vec.__arr;
+        vec.__arr = nullptr;
+    }
+    return *this;
+}
+
+template <typename T>
+auto compact_vector<T>::__head() const noexcept -> __header* {
+    return reinterpret_cast<__header*>(reinterpret_cast<char*>(__arr) - __offset);
+}
+
+template <typename T>
+void compact_vector<T>::__check_length(size_type size) {
+    if (size > __max_size) {
+        throw std::length_error("compact_vector: size exceeds 2^32 - 1");
+    }
+}
+
+// Returns a pointer to the first element slot, the header precedes it
+template <typename T>
+auto compact_vector<T>::__allocate(size_type capacity) -> pointer_type {
+    __check_length(capacity);
+    char *block = static_cast<char*>(__storage_allocate(__offset + capacity * sizeof(value_type)));
+
+    ::new (static_cast<void*>(block)) __header{ 0, (unsigned int)capacity };
+    return reinterpret_cast<pointer_type>(block + __offset);
+}
+
+template <typename T>
+void compact_vector<T>::__deallocate(pointer_type arr) {
+    if (!arr) {
+        return;
+    }
+
+    char *block = reinterpret_cast<char*>(arr) - __offset;
+    size_type capacity = reinterpret_cast<__header*>(block)->capacity;
+    __storage_deallocate(block, __offset + capacity * sizeof(value_type));
+}
+
+template <typename T>
+void compact_vector<T>::__reallocate(size_type capacity) {
+    size_type size = this->size();
+    pointer_type dst = __allocate(capacity);
+
+    __move_construct_range(dst, begin(), end());
+
+    __destruct_range(begin(), end());
+    __deallocate(__arr);
+
+    __arr = dst;
+    __head()->size = (unsigned int)size;
+}
+
+template <typename T>
+template <typename... Args>
+void compact_vector<T>::__construct(const_pointer_type pos, Args&&... args) {
+    __storage_construct(pos, ::forward<Args>(args)...);
+}
+
+template <typename T>
+void compact_vector<T>::__move_construct_range(const_pointer_type dst,
+                                               pointer_type begin, pointer_type end) {
+    __storage_move_construct_range(dst, begin, end);
+}
+
+template <typename T>
+void compact_vector<T>::__destruct(pointer_type pos) {
+    pos->~value_type();
+}
+
+template <typename T>
+void compact_vector<T>::__destruct_range(pointer_type begin, pointer_type end) {
+    __storage_destruct_range(begin, end);
+}
+
+#endif /* _COMPACT_VECTOR_H */
@@ -0,0 +1,432 @@
+#ifndef _GAP_VECTOR_H
+#define _GAP_VECTOR_H
+
+#include "storage.h"
+
+
+// Gap buffer: elements live in [0, __gap_begin) and [__gap_end, __capacity)
+// of one allocation, and the unused capacity sits between them at the last
+// edit point. Inserting or erasing next to the previous edit only moves the
+// elements between the old and the new position, so clustered edits are
+// O(1) amortized instead of shifting the whole tail.
+// Arguments to insert/emplace must not refer to elements of the container.
+template <typename T>
+class gap_vector {
+public:
+    typedef T value_type;
+    typedef T* pointer_type;
+    typedef T const* const_pointer_type;
+    typedef T& reference_type;
+    typedef T const& const_reference_type;
+    typedef unsigned long size_type;
+
+    template <typename P>
+    struct segment {
+        P first;
+        P last;
+
+        P begin() const noexcept { return first; }
+        P end() const noexcept { return last; }
+        size_type size() const noexcept { return size_type(last - first); }
+        bool empty() const noexcept { return first == last; }
+    };
+
+private:
+    value_type *__arr;
+    size_type __gap_begin;
+    size_type __gap_end;
+    size_type __capacity;
+
+public:
+    gap_vector();
+    explicit gap_vector(size_type size);
+    gap_vector(gap_vector const &vec);
+    gap_vector(gap_vector &&vec);
+    ~gap_vector();
+
+    void push_back(value_type const &value);
+    void push_back(value_type &&value);
+    void pop_back();
+    template <typename... Args>
+    reference_type emplace_back(Args&&... args);
+
+    void insert(size_type pos, value_type const &value);
+    void insert(size_type pos, value_type &&value);
+    template <typename... Args>
+    reference_type emplace(size_type pos, Args&&... args);
+
+    void erase(size_type pos);
+    void erase(size_type begin, size_type end);
+
+    void swap(gap_vector &other);
+    void clear();
+
+    void reserve(size_type capacity);
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    size_type gap() const noexcept;
+
+    segment<pointer_type> front_segment();
+    segment<pointer_type> back_segment();
+    segment<const_pointer_type> front_segment() const;
+    segment<const_pointer_type> back_segment() const;
+
+    reference_type front();
+    reference_type back();
+    reference_type at(size_type index);
+    const_reference_type front() const;
+    const_reference_type back() const;
+    const_reference_type at(size_type index) const;
+
+    reference_type operator[](size_type index);
+    const_reference_type operator[](size_type index) const;
+    gap_vector& operator=(gap_vector const &vec);
+    gap_vector& operator=(gap_vector &&vec);
+
+private:
+    [[nodiscard]] pointer_type __allocate(size_type capacity);
+    void __deallocate(const_pointer_type pos, size_type capacity);
+
+    template <typename... Args>
+    void __construct(const_pointer_type pos, Args&&... args);
+    void __copy_construct_range(const_pointer_type dst,
+                                const_pointer_type begin, const_pointer_type end);
+    void __move_construct_range(const_pointer_type dst,
+                                pointer_type begin, pointer_type end);
+
+    void __destruct(pointer_type pos);
+    void __destruct_range(pointer_type begin, pointer_type end);
+
+    void __move_gap(size_type pos);
+    void __grow(size_type capacity);
+};
+
+
+template <typename T>
+gap_vector<T>::gap_vector()
+    : __arr(nullptr)
+    , __gap_begin(0)
+    , __gap_end(0)
+    , __capacity(0)
+{}
+
+template <typename T>
+gap_vector<T>::gap_vector(size_type size)
+    : __arr(__allocate(size))
+    , __gap_begin(size)
+    , __gap_end(size)
+    , __capacity(size) {
+    for (size_type idx = 0; idx < size; ++idx) {
+        __construct(__arr + idx);
+    }
+}
+
+template <typename T>
+gap_vector<T>::gap_vector(gap_vector const &vec)
+    : __arr(__allocate(vec.__capacity))
+    , __gap_begin(vec.__gap_begin)
+    , __gap_end(vec.__gap_end)
+    , __capacity(vec.__capacity) {
+    __copy_construct_range(__arr, vec.__arr, vec.__arr + __gap_begin);
+    __copy_construct_range(__arr + __gap_end, vec.__arr + __gap_end, vec.__arr + __capacity);
+}
+
+template <typename T>
+gap_vector<T>::gap_vector(gap_vector &&vec)
+    : __arr(vec.__arr)
+    , __gap_begin(vec.__gap_begin)
+    , __gap_end(vec.__gap_end)
+    , __capacity(vec.__capacity) {
+    vec.__arr       = nullptr;
+    vec.__gap_begin = 0;
+    vec.__gap_end   = 0;
+    vec.__capacity  = 0;
+}
+
+template <typename T>
+gap_vector<T>::~gap_vector() {
+    clear();
+    __deallocate(__arr, __capacity);
+    __arr = nullptr;
+}
+
+template <typename T>
+void gap_vector<T>::push_back(value_type const &value) {
+    emplace(size(), value);
+}
+
+template <typename T>
+void gap_vector<T>::push_back(value_type &&value) {
+    emplace(size(), static_cast<value_type&&>(value));
+}
+
+template <typename T>
+void gap_vector<T>::pop_back() {
+    erase(size() - 1);
+}
+
+template <typename T>
+template <typename... Args>
+auto gap_vector<T>::emplace_back(Args&&... args) -> reference_type {
+    return emplace(size(), ::forward<Args>(args)...);
+}
+
+template <typename T>
+void gap_vector<T>::insert(size_type pos, value_type const &value) {
+    emplace(pos, value);
+}
+
+template <typename T>
+void gap_vector<T>::insert(size_type pos, value_type &&value) {
+    emplace(pos, static_cast<value_type&&>(value));
+}
+
+template <typename T>
+template <typename... Args>
+auto gap_vector<T>::emplace(size_type pos, Args&&... args) -> reference_type {
+    if (__gap_begin == __gap_end) {
+        __grow(__capacity == 0 ? 1 : __capacity * 2);
+    }
+
+    __move_gap(pos);
+    __construct(__arr + __gap_begin, ::forward<Args>(args)...);
+    return __arr[__gap_begin++];
+}
+
+template <typename T>
+void gap_vector<T>::erase(size_type pos) {
+    __move_gap(pos);
+    __destruct(__arr + __gap_end++);
+}
+
+template <typename T>
+void gap_vector<T>::erase(size_type begin, size_type end) {
+    __move_gap(begin);
+    __destruct_range(__arr + __gap_end, __arr + __gap_end + (end - begin));
+    __gap_end += end - begin;
+}
+
+template <typename T>
+void gap_vector<T>::swap(gap_vector<T> &other) {
+    auto temp_arr = __arr;
+    auto temp_gap_begin = __gap_begin;
+    auto temp_gap_end = __gap_end;
+    auto temp_capacity = __capacity;
+
+    __arr = other.__arr;
+    __gap_begin = other.__gap_begin;
+    __gap_end = other.__gap_end;
+    __capacity = other.__capacity;
+
+    other.__arr = temp_arr;
+    other.__gap_begin = temp_gap_begin;
+    other.__gap_end = temp_gap_end;
+    other.__capacity = temp_capacity;
+}
+
+template <typename T>
+void gap_vector<T>::clear() {
+    __destruct_range(__arr, __arr + __gap_begin);
+    __destruct_range(__arr + __gap_end, __arr + __capacity);
+    __gap_begin = 0;
+    __gap_end = __capacity;
+}
+
+template <typename T>
+void gap_vector<T>::reserve(size_type capacity) {
+    if (__capacity >= capacity) {
+        return;
+    }
+
+    __grow(capacity);
+}
+
+template <typename T>
+bool gap_vector<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template <typename T>
+auto gap_vector<T>::size() const noexcept -> size_type {
+    return __capacity - (__gap_end - __gap_begin);
+}
+
+template <typename T>
+auto gap_vector<T>::capacity() const noexcept -> size_type {
+    return __capacity;
+}
+
+// index of the gap, i.e. the position of the last edit
+template <typename T>
+auto gap_vector<T>::gap() const noexcept -> size_type {
+    return __gap_begin;
+}
+
+template <typename T>
+auto gap_vector<T>::front_segment() -> segment<pointer_type> {
+    return { __arr, __arr + __gap_begin };
+}
+
+template <typename T>
+auto gap_vector<T>::back_segment() -> segment<pointer_type> {
+    return { __arr + __gap_end, __arr + __capacity };
+}
+
+template <typename T>
+auto gap_vector<T>::front_segment() const -> segment<const_pointer_type> {
+    return { __arr, __arr + __gap_begin };
+}
+
+template <typename T>
+auto gap_vector<T>::back_segment() const -> segment<const_pointer_type> {
+    return { __arr + __gap_end, __arr + __capacity };
+}
+
+template <typename T>
+auto gap_vector<T>::front() -> reference_type {
+    return (*this)[0];
+}
+
+template <typename T>
+auto gap_vector<T>::back() -> reference_type {
+    return (*this)[size() - 1];
+}
+
+template <typename T>
+auto gap_vector<T>::at(size_type index) -> reference_type {
+    return (*this)[index];
+}
+
+template <typename T>
+auto gap_vector<T>::front() const -> const_reference_type {
+    return (*this)[0];
+}
+
+template <typename T>
+auto gap_vector<T>::back() const -> const_reference_type {
+    return (*this)[size() - 1];
+}
+
+template <typename T>
+auto gap_vector<T>::at(size_type index) const -> const_reference_type {
+    return (*this)[index];
+}
+
+template <typename T>
+auto gap_vector<T>::operator[](size_type index) -> reference_type {
+    return __arr[index < __gap_begin ? index : index + (__gap_end - __gap_begin)];
+}
+
+template <typename T>
+auto gap_vector<T>::operator[](size_type index) const -> const_reference_type {
+    return __arr[index < __gap_begin ? index : index + (__gap_end - __gap_begin)];
+}
+
+template <typename T>
+gap_vector<T>& gap_vector<T>::operator=(gap_vector<T> const &vec) {
+    if (this != &vec) {
+        gap_vector<T> temp(vec);
+        swap(temp);
+    }
+    return *this;
+}
+
+template <typename T>
+gap_vector<T>& gap_vector<T>::operator=(gap_vector<T> &&vec) {
+    if (this != &vec) {
+        clear();
+        __deallocate(__arr, __capacity);
+
+        __arr       = vec.__arr;
+        __gap_begin = vec.__gap_begin;
+        __gap_end   = vec.__gap_end;
+        __capacity  = vec.__capacity;
+
+        vec.__arr       = nullptr;
+        vec.__gap_begin = 0;
+        vec.__gap_end   = 0;
+        vec.__capacity  = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+auto gap_vector<T>::__allocate(size_type capacity) -> pointer_type {
+    return static_cast<value_type*>(__storage_allocate(capacity * sizeof(value_type)));
+}
+
+template <typename T>
+void gap_vector<T>::__deallocate(const_pointer_type pos, size_type capacity) {
+    __storage_deallocate(pos, capacity * sizeof(value_type));
+}
+
+template <typename T>
+template <typename... Args>
+void gap_vector<T>::__construct(const_pointer_type pos, Args&&... args) {
+    __storage_construct(pos, ::forward<Args>(args)...);
+}
+
+template <typename T>
+void gap_vector<T>::__copy_construct_range(const_pointer_type dst,
+                                           const_pointer_type begin, const_pointer_type end) {
+    __storage_copy_construct_range(dst, begin, end);
+}
+
+template <typename T>
+void gap_vector<T>::__move_construct_range(const_pointer_type dst,
+                                           pointer_type begin, pointer_type end) {
+    __storage_move_construct_range(dst, begin, end);
+}
+
+template <typename T>
+void gap_vector<T>::__destruct(pointer_type pos) {
+    pos->~value_type();
+}
+
+template <typename T>
+void gap_vector<T>::__destruct_range(pointer_type begin, pointer_type end) {
+    __storage_destruct_range(begin, end);
+}
+
+// Elements between the old and the new gap position cross the gap one by
+// one, each landing on a slot that is either gap or already moved from.
+template <typename T>
+void gap_vector<T>::__move_gap(size_type pos) {
+    if (__gap_begin == __gap_end) {
+        __gap_begin = __gap_end = pos;
+        return;
+    }
+
+    while (__gap_begin > pos) {
+        pointer_type src = __arr + --__gap_begin;
+        __construct(__arr + --__gap_end, static_cast<value_type&&>(*src));
+        __destruct(src);
+    }
+
+    while (__gap_begin < pos) {
+        pointer_type src = __arr + __gap_end++;
+        __construct(__arr + __gap_begin++, static_cast<value_type&&>(*src));
+        __destruct(src);
+    }
+}
+
+// Reallocates keeping the gap where it is, so every new slot joins the gap
+template <typename T>
+void gap_vector<T>::__grow(size_type capacity) {
+    pointer_type dst = __allocate(capacity);
+    size_type tail = __capacity - __gap_end;
+
+    __move_construct_range(dst, __arr, __arr + __gap_begin);
+    __move_construct_range(dst + capacity - tail, __arr + __gap_end, __arr + __capacity);
+
+    __destruct_range(__arr, __arr + __gap_begin);
+    __destruct_range(__arr + __gap_end, __arr + __capacity);
+    __deallocate(__arr, __capacity);
+
+    __arr = dst;
+    __gap_end = capacity - tail;
+    __capacity = capacity;
+}
+
+#endif /* _GAP_VECTOR_H */
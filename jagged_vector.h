@@ -0,0 +1,292 @@
+#ifndef _JAGGED_VECTOR_H
+#define _JAGGED_VECTOR_H
+
+#include "utility.h"
+#include "vector.h"
+
+
+// Sequence of variable length rows flattened into a single vector<T>.
+// Every row is a [begin, end) range of the value vector, so a scan walks
+// one contiguous buffer and copying the whole thing is two allocations.
+// Appending to the row stored last is a plain push_back. Appending to any
+// other row first moves that row to the tail, and erased or moved rows leave
+// garbage behind. Once the garbage outgrows the live values the rows are
+// packed back to back again, compact() does the same on demand.
+template <typename T>
+class jagged_vector {
+public:
+    typedef T value_type;
+    typedef T* pointer_type;
+    typedef T const* const_pointer_type;
+    typedef T& reference_type;
+    typedef T const& const_reference_type;
+    typedef unsigned long size_type;
+
+    template <typename P>
+    struct span {
+        P first;
+        P last;
+
+        P begin() const noexcept { return first; }
+        P end() const noexcept { return last; }
+        size_type size() const noexcept { return size_type(last - first); }
+        bool empty() const noexcept { return first == last; }
+        decltype(auto) operator[](size_type index) const noexcept { return first[index]; }
+    };
+
+    typedef span<pointer_type> row_type;
+    typedef span<const_pointer_type> const_row_type;
+
+private:
+    struct __row {
+        size_type begin;
+        size_type end;
+    };
+
+    vector<value_type> __values;
+    vector<__row> __rows;
+    size_type __garbage;
+
+public:
+    jagged_vector();
+
+    size_type push_row();
+    template <typename P>
+    size_type push_row(P begin, P end);
+    void erase_row(size_type row);
+
+    void push_back(size_type row, value_type const &value);
+    void push_back(size_type row, value_type &&value);
+    template <typename... Args>
+    reference_type emplace_back(size_type row, Args&&... args);
+
+    template <typename Pair>
+    void assign(Pair const *begin, Pair const *end, size_type rows);
+    void compact();
+    void reserve(size_type rows, size_type values);
+    void clear();
+
+    bool empty() const noexcept;
+    size_type rows() const noexcept;
+    size_type size() const noexcept;
+    size_type garbage() const noexcept;
+
+    row_type row(size_type index);
+    const_row_type row(size_type index) const;
+
+    row_type operator[](size_type index);
+    const_row_type operator[](size_type index) const;
+
+private:
+    void __to_tail(size_type row);
+    void __compact(size_type tail);
+};
+
+
+template <typename T>
+jagged_vector<T>::jagged_vector()
+    : __values()
+    , __rows()
+    , __garbage(0)
+{}
+
+template <typename T>
+auto jagged_vector<T>::push_row() -> size_type {
+    __rows.push_back({ __values.size(), __values.size() });
+    return __rows.size() - 1;
+}
+
+template <typename T>
+template <typename P>
+auto jagged_vector<T>::push_row(P begin, P end) -> size_type {
+    size_type row = push_row();
+
+    for (; begin != end; ++begin) {
+        __values.push_back(*begin);
+    }
+
+    __rows[row].end = __values.size();
+    return row;
+}
+
+// Later rows shift down by one, the erased values stay as garbage
+template <typename T>
+void jagged_vector<T>::erase_row(size_type row) {
+    __garbage += __rows[row].end - __rows[row].begin;
+    __rows.erase(__rows.begin() + row);
+
+    if (__garbage > size()) {
+        __compact(__rows.size());
+    }
+}
+
+template <typename T>
+void jagged_vector<T>::push_back(size_type row, value_type const &value) {
+    emplace_back(row, value);
+}
+
+template <typename T>
+void jagged_vector<T>::push_back(size_type row, value_type &&value) {
+    emplace_back(row, static_cast<value_type&&>(value));
+}
+
+// The value is built before a row is relocated, args may then still refer
+// into the container since relocating reallocates the values
+template <typename T>
+template <typename... Args>
+auto jagged_vector<T>::emplace_back(size_type row, Args&&... args) -> reference_type {
+    if (__rows[row].end != __values.size()) {
+        value_type value(::forward<Args>(args)...);
+        __to_tail(row);
+
+        ++__rows[row].end;
+        return __values.emplace_back(static_cast<value_type&&>(value));
+    }
+
+    ++__rows[row].end;
+    return __values.emplace_back(::forward<Args>(args)...);
+}
+
+// Builds rows from (row, value) pairs with a counting sort, values keep
+// their input order within a row. Any previous contents are dropped.
+template <typename T>
+template <typename Pair>
+void jagged_vector<T>::assign(Pair const *begin, Pair const *end, size_type rows) {
+    clear();
+    __rows.resize(rows);
+    __values.resize(size_type(end - begin));
+
+    for (Pair const *pair = begin; pair != end; ++pair) {
+        ++__rows[size_type(pair->first)].end;
+    }
+
+    size_type offset = 0;
+    for (auto &row : __rows) {
+        size_type count = row.end;
+        row.begin = row.end = offset;
+        offset += count;
+    }
+
+    for (Pair const *pair = begin; pair != end; ++pair) {
+        __values[__rows[size_type(pair->first)].end++] = pair->second;
+    }
+}
+
+// Moves every row back to back in row order and drops the garbage
+template <typename T>
+void jagged_vector<T>::compact() {
+    if (__garbage == 0) {
+        return;
+    }
+
+    __compact(__rows.size());
+}
+
+template <typename T>
+void jagged_vector<T>::reserve(size_type rows, size_type values) {
+    __rows.reserve(rows);
+    __values.reserve(values);
+}
+
+template <typename T>
+void jagged_vector<T>::clear() {
+    __values.clear();
+    __rows.clear();
+    __garbage = 0;
+}
+
+template <typename T>
+bool jagged_vector<T>::empty() const noexcept {
+    return __rows.empty();
+}
+
+template <typename T>
+auto jagged_vector<T>::rows() const noexcept -> size_type {
+    return __rows.size();
+}
+
+// Number of live values, not counting garbage
+template <typename T>
+auto jagged_vector<T>::size() const noexcept -> size_type {
+    return __values.size() - __garbage;
+}
+
+template <typename T>
+auto jagged_vector<T>::garbage() const noexcept -> size_type {
+    return __garbage;
+}
+
+template <typename T>
+auto jagged_vector<T>::row(size_type index) -> row_type {
+    return { __values.begin() + __rows[index].begin, __values.begin() + __rows[index].end };
+}
+
+template <typename T>
+auto jagged_vector<T>::row(size_type index) const -> const_row_type {
+    return { __values.begin() + __rows[index].begin, __values.begin() + __rows[index].end };
+}
+
+template <typename T>
+auto jagged_vector<T>::operator[](size_type index) -> row_type {
+    return row(index);
+}
+
+template <typename T>
+auto jagged_vector<T>::operator[](size_type index) const -> const_row_type {
+    return row(index);
+}
+
+// Moves a row behind the last value so it can grow in place. The old
+// slots become garbage, still holding moved from values.
+template <typename T>
+void jagged_vector<T>::__to_tail(size_type row) {
+    size_type begin = __values.size();
+
+    for (size_type idx = __rows[row].begin; idx != __rows[row].end; ++idx) {
+        __values.push_back(static_cast<value_type&&>(__values[idx]));
+    }
+
+    __garbage += __rows[row].end - __rows[row].begin;
+    __rows[row].begin = begin;
+    __rows[row].end = __values.size();
+
+    if (__garbage > size()) {
+        __compact(row);
+    }
+}
+
+// Packs the rows back to back in row order, except tail which is placed
+// last so that it can keep growing in place. Every value moves once and
+// the garbage has outgrown the live values, so the cost is amortized over
+// the moves that created it.
+template <typename T>
+void jagged_vector<T>::__compact(size_type tail) {
+    vector<value_type> values;
+    values.reserve(size());
+
+    auto move_row = [&](__row &row) {
+        size_type begin = values.size();
+
+        for (size_type idx = row.begin; idx != row.end; ++idx) {
+            values.push_back(static_cast<value_type&&>(__values[idx]));
+        }
+
+        row.begin = begin;
+        row.end = values.size();
+    };
+
+    for (size_type idx = 0; idx != __rows.size(); ++idx) {
+        if (idx != tail) {
+            move_row(__rows[idx]);
+        }
+    }
+
+    if (tail < __rows.size()) {
+        move_row(__rows[tail]);
+    }
+
+    __values.swap(values);
+    __garbage = 0;
+}
+
+#endif /* _JAGGED_VECTOR_H */
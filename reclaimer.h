@@ -0,0 +1,225 @@
+#ifndef _RECLAIMER_H
+#define _RECLAIMER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+// Background thread destroying and freeing vector storage handed over by
+// the releasing thread. Enabled by building with -DVECTOR_DEFERRED_RECLAIM
+// for the whole program, never by a #define before one include: the macro
+// changes inline vector code, so translation units must agree on it.
+// Buffers below threshold() are still released inline.
+// The queue holds at most queue_size buffers and limit() bytes of them,
+// anything beyond that is destroyed synchronously by the caller.
+class reclaimer {
+public:
+    typedef unsigned long size_type;
+    typedef void (*destroy_type)(void *arr, size_type size, size_type capacity);
+
+    static constexpr size_type queue_size        = 1024;
+    static constexpr size_type default_limit     = 256ul << 20;
+    static constexpr size_type default_threshold = 256ul << 10;
+
+private:
+    struct __entry {
+        void *arr;
+        size_type size;
+        size_type capacity;
+        size_type bytes;
+        destroy_type destroy;
+    };
+
+    __entry __queue[queue_size];
+    size_type __head;
+    size_type __count;
+    size_type __pending;
+    bool __busy;
+    bool __stop;
+
+    std::atomic<bool> __enabled;
+    std::atomic<size_type> __limit;
+    std::atomic<size_type> __threshold;
+    std::atomic<size_type> __deferred;
+    std::atomic<size_type> __fallbacks;
+
+    std::mutex __lock;
+    std::condition_variable __work_cv;
+    std::condition_variable __idle_cv;
+    std::thread __worker;
+
+    inline static std::atomic<bool> __torn_down = false;
+
+public:
+    reclaimer();
+    reclaimer(reclaimer const &other) = delete;
+    ~reclaimer();
+
+    reclaimer& operator=(reclaimer const &other) = delete;
+
+    static reclaimer& instance();
+    static bool accepts(size_type bytes) noexcept;
+    static bool defer(void *arr, size_type size, size_type capacity,
+                      size_type bytes, destroy_type destroy);
+
+    void enable(bool enabled) noexcept;
+    void limit(size_type bytes) noexcept;
+    void threshold(size_type bytes) noexcept;
+    void drain();
+
+    bool enabled() const noexcept;
+    size_type limit() const noexcept;
+    size_type threshold() const noexcept;
+    size_type deferred() const noexcept;
+    size_type fallbacks() const noexcept;
+
+private:
+    bool __push(__entry const &entry);
+    void __worker_loop();
+};
+
+
+inline reclaimer::reclaimer()
+    : __queue()
+    , __head(0)
+    , __count(0)
+    , __pending(0)
+    , __busy(false)
+    , __stop(false)
+    , __enabled(true)
+    , __limit(default_limit)
+    , __threshold(default_threshold)
+    , __deferred(0)
+    , __fallbacks(0)
+    , __worker([this] { __worker_loop(); })
+{}
+
+// Whatever is still queued is destroyed before the worker exits
+inline reclaimer::~reclaimer() {
+    {
+        std::lock_guard<std::mutex> guard(__lock);
+        __stop = true;
+    }
+    __work_cv.notify_one();
+    __worker.join();
+    __torn_down = true;
+}
+
+inline reclaimer& reclaimer::instance() {
+    static reclaimer instance;
+    return instance;
+}
+
+inline bool reclaimer::accepts(size_type bytes) noexcept {
+    if (__torn_down.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    reclaimer &self = instance();
+    return self.__enabled.load(std::memory_order_relaxed)
+        && bytes >= self.__threshold.load(std::memory_order_relaxed);
+}
+
+// Returns false when the caller has to destroy the buffer itself
+inline bool reclaimer::defer(void *arr, size_type size, size_type capacity,
+                             size_type bytes, destroy_type destroy) {
+    if (!arr || !accepts(bytes)) {
+        return false;
+    }
+
+    reclaimer &self = instance();
+    if (self.__push({ arr, size, capacity, bytes, destroy })) {
+        self.__deferred.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    self.__fallbacks.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+inline void reclaimer::enable(bool enabled) noexcept {
+    __enabled = enabled;
+}
+
+inline void reclaimer::limit(size_type bytes) noexcept {
+    __limit = bytes;
+}
+
+inline void reclaimer::threshold(size_type bytes) noexcept {
+    __threshold = bytes;
+}
+
+// Blocks until every buffer queued so far has been released
+inline void reclaimer::drain() {
+    std::unique_lock<std::mutex> lock(__lock);
+    __idle_cv.wait(lock, [this] { return __count == 0 && !__busy; });
+}
+
+inline bool reclaimer::enabled() const noexcept {
+    return __enabled;
+}
+
+inline auto reclaimer::limit() const noexcept -> size_type {
+    return __limit;
+}
+
+inline auto reclaimer::threshold() const noexcept -> size_type {
+    return __threshold;
+}
+
+inline auto reclaimer::deferred() const noexcept -> size_type {
+    return __deferred;
+}
+
+inline auto reclaimer::fallbacks() const noexcept -> size_type {
+    return __fallbacks;
+}
+
+inline bool reclaimer::__push(__entry const &entry) {
+    {
+        std::lock_guard<std::mutex> guard(__lock);
+
+        if (__stop || __count == queue_size
+            || __pending + entry.bytes > __limit.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        __queue[(__head + __count++) % queue_size] = entry;
+        __pending += entry.bytes;
+    }
+
+    __work_cv.notify_one();
+    return true;
+}
+
+inline void reclaimer::__worker_loop() {
+    std::unique_lock<std::mutex> lock(__lock);
+
+    while (true) {
+        __work_cv.wait(lock, [this] { return __stop || __count != 0; });
+
+        if (__count == 0) {
+            return;
+        }
+
+        __entry entry = __queue[__head];
+        __head = (__head + 1) % queue_size;
+        --__count;
+        __busy = true;
+
+        lock.unlock();
+        entry.destroy(entry.arr, entry.size, entry.capacity);
+        lock.lock();
+
+        __pending -= entry.bytes;
+        __busy = false;
+
+        if (__count == 0) {
+            __idle_cv.notify_all();
+        }
+    }
+}
+
+#endif /* _RECLAIMER_H */
@@ -0,0 +1,58 @@
+#ifndef _STORAGE_H
+#define _STORAGE_H
+
+#include <new>
+#include "utility.h"
+
+#ifdef VECTOR_BUFFER_CACHE
+#include "buffer_cache.h"
+#endif
+
+
+// Raw storage and element lifetime helpers shared by vector, gap_vector
+// and compact_vector. This is the only place choosing between the buffer
+// cache and the global operator new, see buffer_cache.h on how to set
+// VECTOR_BUFFER_CACHE.
+inline void* __storage_allocate(unsigned long bytes) {
+#ifdef VECTOR_BUFFER_CACHE
+    return buffer_cache::allocate(bytes);
+#else
+    return ::operator new(bytes);
+#endif
+}
+
+inline void __storage_deallocate(void const volatile *pos, [[maybe_unused]] unsigned long bytes) {
+#ifdef VECTOR_BUFFER_CACHE
+    buffer_cache::deallocate(const_cast<void*>(pos), bytes);
+#else
+    ::operator delete(const_cast<void*>(pos));
+#endif
+}
+
+template <typename T, typename... Args>
+void __storage_construct(T const *pos, Args&&... args) {
+    ::new (const_cast<void*>(static_cast<const volatile void*>(pos))) T(::forward<Args>(args)...);
+}
+
+template <typename T>
+void __storage_copy_construct_range(T const *dst, T const *begin, T const *end) {
+    for (; begin != end; ++dst, ++begin) {
+        __storage_construct(dst, *begin);
+    }
+}
+
+template <typename T>
+void __storage_move_construct_range(T const *dst, T *begin, T *end) {
+    for (; begin != end; ++dst, ++begin) {
+        __storage_construct(dst, static_cast<T&&>(*begin));
+    }
+}
+
+template <typename T>
+void __storage_destruct_range(T *begin, T *end) {
+    for (; begin != end; ++begin) {
+        begin->~T();
+    }
+}
+
+#endif /* _STORAGE_H */
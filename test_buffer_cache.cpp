@@ -0,0 +1,102 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <string>
+#include <algorithm>
+
+// g++ -std=c++20 -O2 -pthread -DVECTOR_BUFFER_CACHE test_buffer_cache.cpp
+#ifndef VECTOR_BUFFER_CACHE
+#error "build with -DVECTOR_BUFFER_CACHE, the switch has to be program wide"
+#endif
+#include "vector.h"
+
+
+constexpr int vector_cnt = 200000;
+constexpr int max_elements = 512;
+
+
+struct result {
+    std::size_t allocations = 0;
+    std::size_t hits = 0;
+    std::vector<long> latency;
+};
+
+struct foo {
+    int value;
+    long dummy[3] = { 0, };
+
+    foo(int n) : value(n) {}
+};
+
+
+void churn(bool cached, unsigned seed, result& out) {
+    buffer_cache::local().enable(cached);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(1, max_elements);
+    out.latency.reserve(vector_cnt);
+
+    for (int i = 0; i < vector_cnt; ++i) {
+        int cnt = dist(gen);
+        auto start = std::chrono::steady_clock::now();
+        {
+            vector<int> ints;
+            vector<foo> foos;
+            for (int n = 0; n < cnt; ++n) {
+                ints.push_back(n);
+                foos.emplace_back(n);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        out.latency.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    out.allocations = buffer_cache::local().hits() + buffer_cache::local().misses();
+    out.hits = buffer_cache::local().hits();
+}
+
+void benchmark_impl(bool cached, unsigned threads) {
+    std::vector<result> results(threads);
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned idx = 0; idx < threads; ++idx) {
+        workers.emplace_back(churn, cached, idx + 1, std::ref(results[idx]));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::size_t allocations = 0;
+    std::size_t hits = 0;
+    std::vector<long> latency;
+    for (auto& res : results) {
+        allocations += res.allocations;
+        hits += res.hits;
+        latency.insert(latency.end(), res.latency.begin(), res.latency.end());
+    }
+    std::sort(latency.begin(), latency.end());
+
+    auto percentile = [&](double p) { return latency[(std::size_t)(p * (double)(latency.size() - 1))]; };
+
+    std::cout << (cached ? "Cache on" : "Cache off") << ", threads: " << threads << "\n\n"
+        << "chrono: " << (long)(seconds * 1e6) << '\n'
+        << "allocations/s: " << (long)((double)allocations / seconds) << '\n'
+        << "cache hits: " << hits << " / " << allocations << '\n'
+        << "p50 ns: " << percentile(0.50) << '\n'
+        << "p99 ns: " << percentile(0.99) << '\n'
+        << "p99.9 ns: " << percentile(0.999) << "\n\n";
+}
+
+
+auto main() -> int {
+    unsigned max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        benchmark_impl(false, threads);
+        benchmark_impl(true, threads);
+    }
+}
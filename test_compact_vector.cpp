@@ -0,0 +1,88 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "test_heap.h"
+#include "vector.h"
+#include "compact_vector.h"
+
+
+constexpr std::size_t list_cnt = 1000000;
+constexpr int max_degree = 8;
+constexpr int lookup_cnt = 10000000;
+
+
+// Roughly a third of the lists stay empty, the rest hold 1..max_degree values
+std::vector<int> make_degrees() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(-max_degree / 2, max_degree);
+
+    std::vector<int> degrees(list_cnt);
+    for (auto& degree : degrees) {
+        degree = std::max(dist(gen), 0);
+    }
+    return degrees;
+}
+
+template <typename T>
+void benchmark_impl(std::string const& name, std::vector<int> const& degrees) {
+    std::size_t base_allocations = allocation_cnt;
+    std::size_t base_bytes = live_bytes;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::unique_ptr<T[]> lists(new T[list_cnt]);
+    for (std::size_t idx = 0; idx < list_cnt; ++idx) {
+        for (int n = 0; n < degrees[idx]; ++n) {
+            lists[idx].push_back(n + (int)idx);
+        }
+    }
+
+    auto built = std::chrono::high_resolution_clock::now();
+    std::size_t allocations = allocation_cnt - base_allocations - 1;
+    std::size_t bytes = live_bytes - base_bytes;
+
+    long sum = 0;
+    for (std::size_t idx = 0; idx < list_cnt; ++idx) {
+        for (auto value : lists[idx]) {
+            sum += value;
+        }
+    }
+
+    auto scanned = std::chrono::high_resolution_clock::now();
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<std::size_t> pick(0, list_cnt - 1);
+    for (int i = 0; i < lookup_cnt; ++i) {
+        auto& list = lists[pick(gen)];
+        if (!list.empty()) {
+            sum += list[list.size() - 1];
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto us = [](auto diff) { return std::chrono::duration_cast<std::chrono::microseconds>(diff).count(); };
+
+    std::cout << "Container: " << name << "\n\n"
+        << "sizeof: " << sizeof(T) << '\n'
+        << "live allocations: " << allocations << '\n'
+        << "live heap bytes: " << bytes << '\n'
+        << "bytes per list: " << (double)bytes / list_cnt << '\n'
+        << "build chrono: " << us(built - start) << '\n'
+        << "scan chrono: " << us(scanned - built) << '\n'
+        << "lookup chrono: " << us(end - scanned) << '\n'
+        << "checksum: " << sum << "\n\n";
+}
+
+
+auto main() -> int {
+    auto degrees = make_degrees();
+
+    benchmark_impl<vector<int>>("vector", degrees);
+    benchmark_impl<compact_vector<int>>("compact_vector", degrees);
+    benchmark_impl<std::vector<int>>("std::vector", degrees);
+}
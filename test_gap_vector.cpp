@@ -0,0 +1,164 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <array>
+#include <tuple>
+#include <string>
+#include <random>
+
+#include "vector.h"
+#include "gap_vector.h"
+
+
+constexpr int initial_cnt = 50000;
+constexpr int edit_cnt = 20000;
+constexpr int max_step = 8;
+
+
+std::size_t constructor_cnt;
+std::size_t destructor_cnt;
+std::size_t copy_cnt;
+std::size_t move_cnt;
+std::size_t assign_cnt;
+std::size_t move_assign_cnt;
+
+
+struct foo {
+    int value;
+    long dummy[12] = { 0, };
+
+    foo() : foo(42) {}
+    foo(int n) : value(n) { ++constructor_cnt; }
+    foo(foo const& o) : value(o.value) { ++copy_cnt; }
+    foo(foo&& o) noexcept : value(o.value) { ++move_cnt; }
+    ~foo() { ++destructor_cnt; }
+
+    foo &operator=(foo const& o) { value = o.value; ++assign_cnt; return *this; }
+    foo &operator=(foo&& o) { value = o.value; ++move_assign_cnt; return *this; }
+
+    bool operator==(foo const &other) { return value == other.value; }
+    bool operator!=(foo const &other) { return value != other.value; }
+};
+
+
+// Cursor takes a short random step, then either inserts or erases there
+struct edit {
+    std::size_t cursor;
+    bool insert;
+};
+
+std::vector<edit> make_edits() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> step(-max_step, max_step);
+    std::uniform_int_distribution<int> kind(0, 2);
+
+    std::vector<edit> edits;
+    long cursor = initial_cnt / 2;
+    long size = initial_cnt;
+
+    for (int i = 0; i < edit_cnt; ++i) {
+        cursor = std::min(std::max(cursor + step(gen), 0l), size - 1);
+        bool insert = kind(gen) != 0;
+        edits.push_back({ (std::size_t)cursor, insert });
+        size += insert ? 1 : -1;
+    }
+    return edits;
+}
+
+
+template <typename T>
+using benchmark_t = std::tuple<std::string, void(*)(T&, edit const&)>;
+
+std::array vector_benchmark = {
+    benchmark_t<vector<foo>>{ "vector",
+        [](auto& vec, auto const& e) -> void {
+            if (e.insert) vec.insert(vec.begin() + e.cursor, {(int)e.cursor});
+            else          vec.erase(vec.begin() + e.cursor); }}
+};
+
+std::array gap_vector_benchmark = {
+    benchmark_t<gap_vector<foo>>{ "gap_vector",
+        [](auto& vec, auto const& e) -> void {
+            if (e.insert) vec.insert(e.cursor, {(int)e.cursor});
+            else          vec.erase(e.cursor); }}
+};
+
+std::array std_benchmark = {
+    benchmark_t<std::vector<foo>>{ "std::vector",
+        [](auto& vec, auto const& e) -> void {
+            if (e.insert) vec.insert(vec.begin() + (long)e.cursor, {(int)e.cursor});
+            else          vec.erase(vec.begin() + (long)e.cursor); }}
+};
+
+
+template <typename T, typename Bench>
+auto benchmark_impl(T& vec, Bench& benchmarks, std::vector<edit> const& edits) {
+    for (int i = 0; i < initial_cnt; ++i) {
+        vec.push_back({i});
+    }
+
+    for (auto& benchmark_func : benchmarks) {
+        constructor_cnt = 0;
+        copy_cnt        = 0;
+        move_cnt        = 0;
+        destructor_cnt  = 0;
+        assign_cnt      = 0;
+        move_assign_cnt = 0;
+
+        auto target_name = std::get<0>(benchmark_func);
+        auto target_func = std::get<1>(benchmark_func);
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (auto const& e : edits) {
+            target_func(vec, e);
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto diff = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+        std::cout << "Function: " << target_name << "\n\n"
+            << "chrono: " << diff.count() << '\n'
+            << "constructor: " << constructor_cnt << '\n'
+            << "copy: " << copy_cnt << '\n'
+            << "move: " << move_cnt << '\n'
+            << "detructor: " << destructor_cnt << '\n'
+            << "assign: " << assign_cnt << '\n'
+            << "move_assign: " << move_assign_cnt << "\n\n";
+    }
+}
+
+
+auto main() -> int {
+    auto edits = make_edits();
+
+    vector<foo> vec;
+    gap_vector<foo> gap_vec;
+    std::vector<foo> std_vec;
+
+    benchmark_impl(vec, vector_benchmark, edits);
+    benchmark_impl(gap_vec, gap_vector_benchmark, edits);
+    benchmark_impl(std_vec, std_benchmark, edits);
+
+    if (gap_vec.size() != std_vec.size() || vec.size() != std_vec.size()) {
+        std::cout << "ERROR: Vector size mismatch!\n";
+        return 0;
+    }
+
+    for (std::size_t idx = 0; idx < std_vec.size(); ++idx) {
+        if (gap_vec[idx] != std_vec[idx] || vec[idx] != std_vec[idx]) {
+            std::cout << "ERROR: Element mismatch detected in " << idx << std::endl;
+            return 0;
+        }
+    }
+
+    std::size_t idx = 0;
+    for (auto segment : { gap_vec.front_segment(), gap_vec.back_segment() }) {
+        for (auto& value : segment) {
+            if (value != std_vec[idx++]) {
+                std::cout << "ERROR: Segment mismatch detected in " << idx - 1 << std::endl;
+                return 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef _TEST_HEAP_H
+#define _TEST_HEAP_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+
+
+// Replaces the global operator new and delete to count live allocations
+// and live heap bytes as seen by malloc, including its rounding. Meant for
+// the single translation unit of a benchmark, include it exactly once.
+std::size_t allocation_cnt;
+std::size_t live_bytes;
+
+void* operator new(std::size_t bytes) {
+    if (void *ptr = std::malloc(bytes == 0 ? 1 : bytes)) {
+        ++allocation_cnt;
+        live_bytes += malloc_usable_size(ptr);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line: once inlined into a caller, gcc sees the free() paired
+// with an operator new and reports a false -Wmismatched-new-delete.
+[[gnu::noinline]] void operator delete(void *ptr) noexcept {
+    if (ptr) {
+        --allocation_cnt;
+        live_bytes -= malloc_usable_size(ptr);
+    }
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+#endif /* _TEST_HEAP_H */
@@ -0,0 +1,113 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "test_heap.h"
+#include "vector.h"
+#include "jagged_vector.h"
+
+
+constexpr std::size_t row_cnt = 1000000;
+constexpr std::size_t value_cnt = 8000000;
+
+
+// Edge list of a random graph, in no particular row order
+std::vector<std::pair<int, int>> make_pairs() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> row(0, (int)row_cnt - 1);
+
+    std::vector<std::pair<int, int>> pairs(value_cnt);
+    for (auto& pair : pairs) {
+        pair = { row(gen), row(gen) };
+    }
+    return pairs;
+}
+
+void build(vector<vector<int>>& rows, std::vector<std::pair<int, int>> const& pairs) {
+    rows.resize(row_cnt);
+    for (auto& pair : pairs) {
+        rows[(std::size_t)pair.first].push_back(pair.second);
+    }
+}
+
+void build(std::vector<std::vector<int>>& rows, std::vector<std::pair<int, int>> const& pairs) {
+    rows.resize(row_cnt);
+    for (auto& pair : pairs) {
+        rows[(std::size_t)pair.first].push_back(pair.second);
+    }
+}
+
+void build(jagged_vector<int>& rows, std::vector<std::pair<int, int>> const& pairs) {
+    rows.assign(pairs.data(), pairs.data() + pairs.size(), row_cnt);
+}
+
+// Same rows grown one value at a time, relocating rows and compacting
+void build_push_back(jagged_vector<int>& rows, std::vector<std::pair<int, int>> const& pairs) {
+    for (std::size_t idx = 0; idx < row_cnt; ++idx) {
+        rows.push_row();
+    }
+    for (auto& pair : pairs) {
+        rows.push_back((std::size_t)pair.first, pair.second);
+    }
+}
+
+template <typename T>
+long scan(T const& rows) {
+    long sum = 0;
+    for (std::size_t idx = 0; idx < row_cnt; ++idx) {
+        for (auto value : rows[idx]) {
+            sum += value;
+        }
+    }
+    return sum;
+}
+
+
+template <typename T>
+void benchmark_impl(std::string const& name, std::vector<std::pair<int, int>> const& pairs,
+                    void (*build_func)(T&, std::vector<std::pair<int, int>> const&) = build) {
+    std::size_t base_allocations = allocation_cnt;
+    std::size_t base_bytes = live_bytes;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    T rows;
+    build_func(rows, pairs);
+    auto built = std::chrono::high_resolution_clock::now();
+
+    std::size_t allocations = allocation_cnt - base_allocations;
+    std::size_t bytes = live_bytes - base_bytes;
+
+    long sum = scan(rows);
+    auto scanned = std::chrono::high_resolution_clock::now();
+
+    T copy(rows);
+    auto copied = std::chrono::high_resolution_clock::now();
+
+    if (scan(copy) != sum) {
+        std::cout << "ERROR: Copy mismatch in " << name << std::endl;
+    }
+
+    auto us = [](auto diff) { return std::chrono::duration_cast<std::chrono::microseconds>(diff).count(); };
+
+    std::cout << "Container: " << name << "\n\n"
+        << "live allocations: " << allocations << '\n'
+        << "live heap bytes: " << bytes << '\n'
+        << "bytes per value: " << (double)bytes / value_cnt << '\n'
+        << "build chrono: " << us(built - start) << '\n'
+        << "scan chrono: " << us(scanned - built) << '\n'
+        << "copy chrono: " << us(copied - scanned) << '\n'
+        << "checksum: " << sum << "\n\n";
+}
+
+
+auto main() -> int {
+    auto pairs = make_pairs();
+
+    benchmark_impl<vector<vector<int>>>("vector<vector>", pairs);
+    benchmark_impl<jagged_vector<int>>("jagged_vector", pairs);
+    benchmark_impl<jagged_vector<int>>("jagged_vector, push_back", pairs, build_push_back);
+    benchmark_impl<std::vector<std::vector<int>>>("std::vector<std::vector>", pairs);
+}
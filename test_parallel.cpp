@@ -0,0 +1,162 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <array>
+#include <tuple>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+// The std::execution comparison is off by default, libstdc++ needs TBB
+// for it: g++ -std=c++20 -O2 -pthread -DTEST_STD_EXECUTION test_parallel.cpp -ltbb
+#if defined(TEST_STD_EXECUTION) && __has_include(<execution>)
+#include <execution>
+#endif
+
+#include "algorithm.h"
+
+
+constexpr std::size_t element_cnt = 1 << 22;
+
+
+template <typename T>
+using benchmark_t = std::tuple<std::string, void(*)(T&, thread_pool&)>;
+
+std::array benchmark = {
+    benchmark_t<vector<double>>{ "for_each",
+        [](auto& vec, auto& pool) -> void {
+            parallel_for_each(vec, [](double& v) { v = std::sqrt(v) + 1.0; }, parallel_default_grain, parallel_default_threshold, pool); }},
+
+    benchmark_t<vector<double>>{ "transform",
+        [](auto& vec, auto& pool) -> void {
+            parallel_transform(vec.begin(), vec.end(), vec.begin(),
+                               [](double v) { return v * 0.5 + 1.0; }, parallel_default_grain, parallel_default_threshold, pool); }},
+
+    benchmark_t<vector<double>>{ "reduce",
+        [](auto& vec, auto& pool) -> void {
+            vec[0] = parallel_reduce(vec, 0.0, std::plus<>(), parallel_default_grain, parallel_default_threshold, pool) * 1e-12; }},
+
+    benchmark_t<vector<double>>{ "inclusive_scan",
+        [](auto& vec, auto& pool) -> void {
+            parallel_inclusive_scan(vec, std::plus<>(), parallel_default_grain, parallel_default_threshold, pool); }},
+
+    benchmark_t<vector<double>>{ "sort",
+        [](auto& vec, auto& pool) -> void {
+            parallel_sort(vec, std::less<>(), parallel_default_grain, parallel_default_threshold, pool); }}
+};
+
+#if defined(TEST_STD_EXECUTION) && defined(__cpp_lib_execution)
+std::array std_benchmark = {
+    benchmark_t<std::vector<double>>{ "for_each",
+        [](auto& vec, auto&) -> void {
+            std::for_each(std::execution::par, vec.begin(), vec.end(),
+                          [](double& v) { v = std::sqrt(v) + 1.0; }); }},
+
+    benchmark_t<std::vector<double>>{ "transform",
+        [](auto& vec, auto&) -> void {
+            std::transform(std::execution::par, vec.begin(), vec.end(), vec.begin(),
+                           [](double v) { return v * 0.5 + 1.0; }); }},
+
+    benchmark_t<std::vector<double>>{ "reduce",
+        [](auto& vec, auto&) -> void {
+            vec[0] = std::reduce(std::execution::par, vec.begin(), vec.end(), 0.0) * 1e-12; }},
+
+    benchmark_t<std::vector<double>>{ "inclusive_scan",
+        [](auto& vec, auto&) -> void {
+            std::inclusive_scan(std::execution::par, vec.begin(), vec.end(), vec.begin()); }},
+
+    benchmark_t<std::vector<double>>{ "sort",
+        [](auto& vec, auto&) -> void {
+            std::sort(std::execution::par, vec.begin(), vec.end()); }}
+};
+#endif
+
+
+template <typename T>
+void fill(T& vec) {
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    vec.resize(element_cnt);
+    for (std::size_t idx = 0; idx < element_cnt; ++idx) {
+        vec[idx] = dist(gen);
+    }
+}
+
+// Compares vec with the output of the same benchmark in the first run,
+// which is recorded instead when there is none yet
+template <typename T>
+bool verify(T const& vec, std::vector<double>& expected, std::string const& name) {
+    if (expected.empty()) {
+        expected.assign(vec.begin(), vec.end());
+        return true;
+    }
+
+    for (std::size_t idx = 0; idx < expected.size(); ++idx) {
+        if (std::abs(vec[idx] - expected[idx]) > 1e-6 * std::abs(expected[idx])) {
+            std::cout << "ERROR: Element mismatch detected in " << name << " at " << idx << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Bench>
+bool benchmark_impl(T& vec, thread_pool& pool, Bench& benchmarks,
+                    std::vector<std::vector<double>>* expected = nullptr) {
+    for (std::size_t bench = 0; bench < benchmarks.size(); ++bench) {
+        auto target_name = std::get<0>(benchmarks[bench]);
+        auto target_func = std::get<1>(benchmarks[bench]);
+
+        // the earlier passes leave the input sorted
+        if (target_name == "sort") {
+            fill(vec);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        target_func(vec, pool);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto diff = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+        std::cout << target_name << ": " << diff.count() << '\n';
+
+        if (expected && !verify(vec, (*expected)[bench], target_name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+auto main() -> int {
+    std::size_t max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+    std::vector<std::vector<double>> expected(benchmark.size());
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        thread_pool pool(threads);
+        vector<double> vec;
+        fill(vec);
+
+        std::cout << "Custome impl, threads: " << threads << "\n\n";
+        if (!benchmark_impl(vec, pool, benchmark, &expected)) {
+            return 0;
+        }
+        std::cout << "\n\n";
+    }
+
+#if defined(TEST_STD_EXECUTION) && defined(__cpp_lib_execution)
+    {
+        thread_pool pool(1);
+        std::vector<double> std_vec;
+        fill(std_vec);
+
+        std::cout << "Standard impl, std::execution::par\n\n";
+        benchmark_impl(std_vec, pool, std_benchmark);
+        std::cout << "\n\n";
+    }
+#else
+    std::cout << "Standard impl, std::execution::par not enabled\n\n";
+#endif
+}
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <array>
+#include <tuple>
+#include <string>
+#include <algorithm>
+
+// g++ -std=c++20 -O2 -pthread -DVECTOR_DEFERRED_RECLAIM test_reclaim.cpp
+#ifndef VECTOR_DEFERRED_RECLAIM
+#error "build with -DVECTOR_DEFERRED_RECLAIM, the switch has to be program wide"
+#endif
+#include "vector.h"
+
+
+constexpr int release_cnt = 200;
+constexpr int element_cnt = 100000;
+
+
+using benchmark_t = std::tuple<std::string, long(*)()>;
+
+// Every case builds one large vector and returns how long dropping its
+// buffer blocked the caller
+std::array benchmark = {
+    benchmark_t{ "destructor",
+        []() -> long {
+            auto vec = new vector<std::string>;
+            for (int n = 0; n < element_cnt; ++n) {
+                vec->emplace_back(48, char('a' + n % 26));
+            }
+            auto start = std::chrono::steady_clock::now();
+            delete vec;
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); }},
+
+    benchmark_t{ "copy_assign",
+        []() -> long {
+            vector<std::string> vec;
+            for (int n = 0; n < element_cnt; ++n) {
+                vec.emplace_back(48, char('a' + n % 26));
+            }
+            vector<std::string> other;
+            auto start = std::chrono::steady_clock::now();
+            vec = other;
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); }},
+
+    benchmark_t{ "move_assign",
+        []() -> long {
+            vector<vector<int>> vec;
+            for (int n = 0; n < element_cnt / 10; ++n) {
+                vec.emplace_back().resize(16);
+            }
+            vector<vector<int>> other;
+            auto start = std::chrono::steady_clock::now();
+            vec = static_cast<vector<vector<int>>&&>(other);
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); }}
+};
+
+
+void benchmark_impl(bool deferred) {
+    reclaimer::instance().enable(deferred);
+
+    for (auto& benchmark_func : benchmark) {
+        auto target_name = std::get<0>(benchmark_func);
+        auto target_func = std::get<1>(benchmark_func);
+
+        auto deferred_cnt = reclaimer::instance().deferred();
+        auto fallback_cnt = reclaimer::instance().fallbacks();
+
+        std::vector<long> latency;
+        for (int i = 0; i < release_cnt; ++i) {
+            latency.push_back(target_func());
+        }
+        reclaimer::instance().drain();
+        std::sort(latency.begin(), latency.end());
+
+        auto percentile = [&](double p) { return latency[(std::size_t)(p * (double)(latency.size() - 1))]; };
+
+        std::cout << "Function: " << target_name << (deferred ? ", deferred" : ", inline") << "\n\n"
+            << "p50 ns: " << percentile(0.50) << '\n'
+            << "p99 ns: " << percentile(0.99) << '\n'
+            << "max ns: " << latency.back() << '\n'
+            << "deferred: " << reclaimer::instance().deferred() - deferred_cnt << '\n'
+            << "fallback: " << reclaimer::instance().fallbacks() - fallback_cnt << "\n\n";
+    }
+}
+
+
+auto main() -> int {
+    benchmark_impl(false);
+    benchmark_impl(true);
+}
@@ -0,0 +1,252 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "vector.h"
+
+
+// Work-stealing pool used by the parallel algorithms.
+// Every worker owns a deque: it pops its own tasks from the back and steals
+// from the front of the others. Threads outside the pool share one extra
+// deque and help running tasks while they wait for their own work.
+class thread_pool {
+public:
+    typedef unsigned long size_type;
+    typedef std::function<void()> task_type;
+
+private:
+    struct __queue {
+        std::mutex lock;
+        std::deque<task_type> tasks;
+    };
+
+    struct __group {
+        std::atomic<size_type> pending{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+    };
+
+    vector<std::thread> __workers;
+    std::unique_ptr<__queue[]> __queues;
+    size_type __queue_cnt;
+    std::atomic<size_type> __queued;
+    std::atomic<bool> __stop;
+    std::mutex __sleep_lock;
+    std::condition_variable __sleep_cv;
+
+    inline static thread_local thread_pool *__current_pool = nullptr;
+    inline static thread_local size_type __current_index = 0;
+
+public:
+    explicit thread_pool(size_type concurrency = 0);
+    thread_pool(thread_pool const &pool) = delete;
+    ~thread_pool();
+
+    thread_pool& operator=(thread_pool const &pool) = delete;
+
+    size_type concurrency() const noexcept;
+
+    template <typename F>
+    void parallel_for(size_type begin, size_type end, size_type grain, F const &func);
+
+    static thread_pool& instance();
+
+private:
+    void __worker_loop(size_type index);
+    void __push(task_type &&task);
+    bool __pop(task_type &task);
+    bool __run_one();
+
+    template <typename F>
+    void __split(__group &group, size_type begin, size_type end,
+                 size_type grain, F const &func);
+    void __fail(__group &group);
+};
+
+
+// concurrency counts the calling thread, so a pool of 1 spawns no workers
+inline thread_pool::thread_pool(size_type concurrency)
+    : __queue_cnt(0)
+    , __queued(0)
+    , __stop(false) {
+    if (concurrency == 0) {
+        concurrency = std::thread::hardware_concurrency();
+        concurrency = concurrency == 0 ? 1 : concurrency;
+    }
+
+    __queue_cnt = concurrency;
+    __queues.reset(new __queue[__queue_cnt]);
+    __workers.reserve(concurrency - 1);
+
+    for (size_type idx = 0; idx < concurrency - 1; ++idx) {
+        __workers.emplace_back([this, idx] { __worker_loop(idx); });
+    }
+}
+
+inline thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(__sleep_lock);
+        __stop = true;
+    }
+    __sleep_cv.notify_all();
+
+    for (auto &worker : __workers) {
+        worker.join();
+    }
+}
+
+inline auto thread_pool::concurrency() const noexcept -> size_type {
+    return __queue_cnt;
+}
+
+// Runs func(lo, hi) over sub-ranges of [begin, end) no longer than grain.
+// The range is split in halves recursively, so idle threads steal the
+// largest pending pieces first. Returns once every piece has finished and
+// rethrows the first exception thrown by func.
+template <typename F>
+void thread_pool::parallel_for(size_type begin, size_type end,
+                               size_type grain, F const &func) {
+    if (begin >= end) {
+        return;
+    }
+
+    __group group;
+    __split(group, begin, end, grain == 0 ? 1 : grain, func);
+
+    while (group.pending.load(std::memory_order_acquire) != 0) {
+        if (!__run_one()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (group.error) {
+        std::rethrow_exception(group.error);
+    }
+}
+
+inline thread_pool& thread_pool::instance() {
+    static thread_pool pool;
+    return pool;
+}
+
+inline void thread_pool::__worker_loop(size_type index) {
+    __current_pool  = this;
+    __current_index = index;
+
+    while (true) {
+        if (__run_one()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(__sleep_lock);
+        __sleep_cv.wait(lock, [this] {
+            return __stop.load() || __queued.load() != 0;
+        });
+
+        if (__stop && __queued == 0) {
+            return;
+        }
+    }
+}
+
+inline void thread_pool::__push(task_type &&task) {
+    size_type index = __current_pool == this ? __current_index : __queue_cnt - 1;
+
+    {
+        std::lock_guard<std::mutex> guard(__queues[index].lock);
+        __queues[index].tasks.push_back(static_cast<task_type&&>(task));
+        __queued.fetch_add(1, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(__sleep_lock);
+    }
+    __sleep_cv.notify_one();
+}
+
+inline bool thread_pool::__pop(task_type &task) {
+    size_type index = __current_pool == this ? __current_index : __queue_cnt - 1;
+
+    {
+        __queue &own = __queues[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+
+        if (!own.tasks.empty()) {
+            task = static_cast<task_type&&>(own.tasks.back());
+            own.tasks.pop_back();
+            __queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    for (size_type offset = 1; offset < __queue_cnt; ++offset) {
+        __queue &victim = __queues[(index + offset) % __queue_cnt];
+        std::lock_guard<std::mutex> guard(victim.lock);
+
+        if (!victim.tasks.empty()) {
+            task = static_cast<task_type&&>(victim.tasks.front());
+            victim.tasks.pop_front();
+            __queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline bool thread_pool::__run_one() {
+    if (__queued.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    task_type task;
+    if (!__pop(task)) {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+template <typename F>
+void thread_pool::__split(__group &group, size_type begin, size_type end,
+                          size_type grain, F const &func) {
+    while (end - begin > grain && __queue_cnt > 1) {
+        size_type mid = begin + (end - begin) / 2;
+
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        __push([this, &group, mid, end, grain, &func] {
+            __split(group, mid, end, grain, func);
+            group.pending.fetch_sub(1, std::memory_order_release);
+        });
+
+        end = mid;
+    }
+
+    if (group.failed.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    try {
+        func(begin, end);
+    }
+    catch (...) {
+        __fail(group);
+    }
+}
+
+inline void thread_pool::__fail(__group &group) {
+    if (!group.failed.exchange(true)) {
+        group.error = std::current_exception();
+    }
+}
+
+#endif /* _THREAD_POOL_H */
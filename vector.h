@@ -1,8 +1,11 @@
 #ifndef _VECTOR_H
 #define _VECTOR_H
 
-#include <new>
-#include "utility.h"
+#include "storage.h"
+
+#ifdef VECTOR_DEFERRED_RECLAIM
+#include "reclaimer.h"
+#endif
 
 
 template <typename T>
@@ -71,7 +74,9 @@ public:
     
 private:
     [[nodiscard]] pointer_type __allocate(size_type capacity);
-    void __deallocate(const_pointer_type pos);
+    static void __deallocate(const_pointer_type pos, size_type capacity);
+    void __release(pointer_type arr, size_type size, size_type capacity);
+    static void __reclaim(void *arr, size_type size, size_type capacity);
     
     template <typename... Args>
     void __construct(const_pointer_type pos, Args&&... args);
@@ -86,7 +91,7 @@ private:
                                    pointer_type rbegin, pointer_type rend);
     
     void __destruct(pointer_type pos);
-    void __destruct_range(pointer_type begin, pointer_type end);
+    static void __destruct_range(pointer_type begin, pointer_type end);
     
     void __copy_range(pointer_type dst,
                       const_pointer_type begin, const_pointer_type end);
@@ -111,10 +116,10 @@ vector<T>::vector(size_type const size)
 
 template <typename T>
 vector<T>::vector(vector const &vec)
-    : __size(vec.__size)
-    , __capacity(vec.__capacity)
-    , __arr(__allocate()) {
-    __copy_range(__arr, vec.begin(), vec.end());
+    : __arr(__allocate(vec.__capacity))
+    , __size(vec.__size)
+    , __capacity(vec.__capacity) {
+    __copy_construct_range(__arr, vec.begin(), vec.end());
 }
 
 template <typename T>
@@ -129,8 +134,7 @@ vector<T>::vector(vector &&vec)
 
 template <typename T>
 vector<T>::~vector() {
-    __destruct_range(begin(), end());
-    __deallocate(__arr);
+    __release(__arr, __size, __capacity);
     __arr = nullptr;
 }
 
@@ -144,11 +148,11 @@ void vector<T>::push_back(const value_type &value) {
         pointer_type new_arr = __allocate(new_cap);
         
         pointer_type dst = new_arr + __size;
-        __construct(dst, value); dst -= 1;
-        __move_construct_backward(dst, end() - 1, begin() - 1);
+        __construct(dst, value);
+        __move_construct_range(new_arr, begin(), end());
         
         __destruct_range(begin(), end());
-        __deallocate(begin());
+        __deallocate(begin(), __capacity);
         
         __arr      = new_arr;
         __capacity = new_cap;
@@ -166,11 +170,11 @@ void vector<T>::push_back(value_type &&value) {
         pointer_type new_arr = __allocate(new_cap);
         
         pointer_type dst = new_arr + __size;
-        __construct(dst, static_cast<value_type&&>(value)); dst -= 1;
-        __move_construct_backward(dst, end() - 1, begin() - 1);
+        __construct(dst, static_cast<value_type&&>(value));
+        __move_construct_range(new_arr, begin(), end());
         
         __destruct_range(begin(), end());
-        __deallocate(begin());
+        __deallocate(begin(), __capacity);
         
         __arr      = new_arr;
         __capacity = new_cap;
@@ -187,18 +191,18 @@ template <typename T>
 template <typename... Args>
 auto vector<T>::emplace_back(Args&&... args) -> reference_type {
     if (__size < __capacity) {
-        __construct(__arr + __size++, forward<Args>(args)...);
+        __construct(__arr + __size++, ::forward<Args>(args)...);
     }
     else {
         size_type new_cap = __capacity == 0 ? 1 : __capacity * 2;
         pointer_type new_arr = __allocate(new_cap);
         
         pointer_type dst = new_arr + __size;
-        __construct(dst, forward<Args>(args)...); dst -= 1;
-        __move_construct_backward(dst, end() - 1, begin() - 1);
+        __construct(dst, ::forward<Args>(args)...);
+        __move_construct_range(new_arr, begin(), end());
         
         __destruct_range(begin(), end());
-        __deallocate(begin());
+        __deallocate(begin(), __capacity);
         
         __arr      = new_arr;
         __capacity = new_cap;
@@ -240,7 +244,7 @@ void vector<T>::insert(const_pointer_type pos,
         __move_construct_range(dst, old_begin + diff, old_end);
         
         __destruct_range(old_begin, old_end);
-        __deallocate(__arr);
+        __deallocate(__arr, __capacity);
         
         __arr      = new_arr;
         __capacity = new_cap;
@@ -286,7 +290,7 @@ void vector<T>::reserve(size_type capacity) {
     __move_construct_range(dst, begin(), end());
     
     __destruct_range(begin(), end());
-    __deallocate(begin());
+    __deallocate(begin(), __capacity);
     
     __arr = dst;
     __capacity = capacity;
@@ -307,7 +311,7 @@ void vector<T>::resize(size_type size) {
             __construct_range(dst + __size, dst + size);
             
             __destruct_range(begin(), end());
-            __deallocate(begin());
+            __deallocate(begin(), __capacity);
             
             __arr = dst;
             __capacity = new_cap;
@@ -338,7 +342,7 @@ void vector<T>::resize(size_type size, value_type const& value) {
             __construct_range(dst + __size, dst + size, value);
             
             __destruct_range(begin(), end());
-            __deallocate(begin());
+            __deallocate(begin(), __capacity);
             
             __arr = dst;
             __capacity = new_cap;
@@ -369,10 +373,12 @@ void vector<T>::swap(vector<T> &other) {
     other.__arr = temp_arr;
 }
 
+// Always destroys inline, even with deferred reclamation, so that the
+// capacity is kept for the refill that usually follows
 template <typename T>
 void vector<T>::clear() {
-    __size = 0;
     __destruct_range(begin(), end());
+    __size = 0;
 }
 
 template <typename T>
@@ -462,10 +468,14 @@ auto vector<T>::operator[](size_type index) const -> const_reference_type {
 
 template <typename T>
 vector<T>& vector<T>::operator=(const vector<T> &vec) {
+    if (this == &vec) {
+        return *this;
+    }
+    
     auto dst = __allocate(vec.__capacity);
     
-    __copy_range(dst, vec.begin(), vec.end());
-    __deallocate(__arr);
+    __copy_construct_range(dst, vec.begin(), vec.end());
+    __release(__arr, __size, __capacity);
     
     __size     = vec.__size;
     __capacity = vec.__capacity;
@@ -475,7 +485,11 @@ vector<T>& vector<T>::operator=(const vector<T> &vec) {
 
 template <typename T>
 vector<T>& vector<T>::operator=(vector<T> &&vec) {
-    __deallocate(__arr);
+    if (this == &vec) {
+        return *this;
+    }
+    
+    __release(__arr, __size, __capacity);
     
     __size     = vec.__size;
     __capacity = vec.__capacity;
@@ -489,42 +503,58 @@ vector<T>& vector<T>::operator=(vector<T> &&vec) {
 
 template <typename T>
 auto vector<T>::__allocate(size_type capacity) -> pointer_type {
-    return static_cast<value_type*>(::operator new(capacity * sizeof(value_type)));
+    return static_cast<value_type*>(__storage_allocate(capacity * sizeof(value_type)));
+}
+
+template <typename T>
+void vector<T>::__deallocate(const_pointer_type pos, size_type capacity) {
+    __storage_deallocate(pos, capacity * sizeof(value_type));
+}
+
+// Destroys and frees a buffer the vector no longer owns, on the reclaimer
+// thread when deferred reclamation is enabled and takes it
+template <typename T>
+void vector<T>::__release(pointer_type arr, size_type size, size_type capacity) {
+#ifdef VECTOR_DEFERRED_RECLAIM
+    if (size != 0 && reclaimer::defer(arr, size, capacity, capacity * sizeof(value_type), &__reclaim)) {
+        return;
+    }
+#endif
+    __reclaim(arr, size, capacity);
 }
 
 template <typename T>
-void vector<T>::__deallocate(const_pointer_type pos) {
-    ::operator delete(const_cast<void*>(static_cast<const volatile void*>(pos)));
+void vector<T>::__reclaim(void *arr, size_type size, size_type capacity) {
+    pointer_type begin = static_cast<pointer_type>(arr);
+    
+    __destruct_range(begin, begin + size);
+    __deallocate(begin, capacity);
 }
 
 template <typename T>
 template <typename... Args>
 void vector<T>::__construct(const_pointer_type pos, Args&&... args) {
-    ::new (const_cast<void*>(static_cast<const volatile void*>(pos))) value_type(forward<Args>(args)...);
+    __storage_construct(pos, ::forward<Args>(args)...);
 }
 
 template <typename T>
 template <typename... Args>
 void vector<T>::__construct_range(const_pointer_type begin, const_pointer_type end, Args&&... args) {
     for (pointer_type loc = const_cast<pointer_type>(begin); loc != end; ++loc) {
-        __construct(loc, forward<Args>(args)...);
+        __construct(loc, ::forward<Args>(args)...);
     }
 }
 
 template <typename T>
 void vector<T>::__copy_construct_range(const_pointer_type dst,
                                        const_pointer_type begin, const_pointer_type end) {
-    for (pointer_type loc = const_cast<pointer_type>(begin); loc != end; ++loc) {
-        __construct(dst, static_cast<const value_type&>(*loc));
-    }
+    __storage_copy_construct_range(dst, begin, end);
 }
 
 template <typename T>
 void vector<T>::__move_construct_range(const_pointer_type dst,
                                        pointer_type begin, pointer_type end) {
-    for (; begin != end; ++dst, ++begin) {
-        __construct(dst, static_cast<value_type&&>(*begin));
-    }
+    __storage_move_construct_range(dst, begin, end);
 }
 
 template <typename T>
@@ -542,9 +572,7 @@ void vector<T>::__destruct(pointer_type pos) {
 
 template <typename T>
 void vector<T>::__destruct_range(pointer_type begin, pointer_type end) {
-    for (; begin != end; ++begin) {
-        begin->~value_type();
-    }
+    __storage_destruct_range(begin, end);
 }
 
 template <typename T>